@@ -0,0 +1,157 @@
+#include "Checkpoint.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * First line of every checkpoint file. Bump the version if the format
+ * changes, so old files are ignored rather than misread.
+ */
+static const string CHECKPOINT_HEADER = "netplan-checkpoint 2";
+
+/**
+ * Constructs a Checkpoint backed by the file at path, loading any
+ * progress already recorded there. Progress is written at most once
+ * per interval.
+ */
+Checkpoint::Checkpoint(const std::string &path, std::chrono::seconds interval)
+{
+    this->path = path;
+    this->interval = interval;
+    this->lastSave = std::chrono::steady_clock::now();
+    this->reportedFailure = false;
+
+    ifstream in(path);
+    string line;
+    if (!in || !getline(in, line) || line != CHECKPOINT_HEADER) {
+        // No usable checkpoint, start from scratch
+        return;
+    }
+    while (getline(in, line)) {
+        istringstream fields(line);
+        uint64_t graphHash;
+        Record record;
+        string partialSum;
+        // Skip malformed records, such as one cut short by a crash
+        if (fields >> graphHash >> record.numSources >> record.sourcesDone
+                   >> partialSum &&
+            parseTotal(partialSum, record.partialSum) &&
+            record.sourcesDone <= record.numSources) {
+            records[graphHash] = record;
+        }
+    }
+}
+
+/**
+ * Looks up the progress recorded for the graph with the given hash and
+ * number of sources. Sets sourcesDone and partialSum and returns true if
+ * a matching record exists. Otherwise, leaves them unchanged and returns
+ * false.
+ */
+bool Checkpoint::resume(uint64_t graphHash, size_t numSources,
+                        size_t &sourcesDone, uint128_t &partialSum) const
+{
+    auto found = records.find(graphHash);
+    if (found == records.end() || found->second.numSources != numSources) {
+        return false;
+    }
+    sourcesDone = found->second.sourcesDone;
+    partialSum = found->second.partialSum;
+    return true;
+}
+
+/**
+ * Records the progress of the sweep over the graph with the given hash.
+ * Writes the file if the interval has passed since the last write, or
+ * if force is set.
+ */
+void Checkpoint::update(uint64_t graphHash, size_t numSources,
+                        size_t sourcesDone, uint128_t partialSum,
+                        bool force)
+{
+    retained.insert(graphHash);
+    Record &record = records[graphHash];
+    record.numSources = numSources;
+    record.sourcesDone = sourcesDone;
+    record.partialSum = partialSum;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - lastSave < interval) {
+        return;
+    }
+    lastSave = now;
+    if (!save() && !reportedFailure) {
+        std::cerr << "Unable to write checkpoint file: " << path << std::endl;
+        reportedFailure = true;
+    }
+}
+
+/**
+ * Marks the graph with the given hash as part of this run, so any
+ * progress recorded for it is kept when the file is next written.
+ */
+void Checkpoint::retain(uint64_t graphHash)
+{
+    retained.insert(graphHash);
+}
+
+/**
+ * Writes the records of all retained graphs to the file. Returns false if
+ * the file could not be written.
+ */
+bool Checkpoint::save()
+{
+    ostringstream contents;
+    contents << CHECKPOINT_HEADER << "\n";
+    for (auto &currentRecord : records) {
+        if (!retained.count(currentRecord.first)) {
+            continue;
+        }
+        contents << currentRecord.first << " "
+                 << currentRecord.second.numSources << " "
+                 << currentRecord.second.sourcesDone << " "
+                 << totalToString(currentRecord.second.partialSum) << "\n";
+    }
+    string data = contents.str();
+
+    // Write a new file next to the old one and sync it before swapping it
+    // in, so the checkpoint on disk is always complete. The pid keeps two
+    // runs sharing a checkpoint from writing the same temporary file.
+    string tempPath = path + "." + to_string(getpid()) + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool written = true;
+    for (size_t offset = 0; written && offset < data.size();) {
+        ssize_t count = write(fd, data.data() + offset, data.size() - offset);
+        if (count < 0 && errno != EINTR) {
+            written = false;
+        } else if (count > 0) {
+            offset += count;
+        }
+    }
+    written = fsync(fd) == 0 && written;
+    written = close(fd) == 0 && written;
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Sync the directory too, so the rename itself survives a crash
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : path.substr(0, slash + 1);
+    int directoryFd = open(directory.c_str(), O_RDONLY);
+    if (directoryFd >= 0) {
+        fsync(directoryFd);
+        close(directoryFd);
+    }
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+
+#include "Weights.hpp"
+
+/**
+ * Persists the progress of all-pairs shortest path sweeps to a small file,
+ * so a run that is killed part way through can resume where it left off.
+ *
+ * The file holds one record per sweep, keyed by a hash of the graph being
+ * swept. Each record is the number of sources in the graph, how many of
+ * them have been finished (sources are swept in a fixed order), and the
+ * partial sum of their distances. Sums are stored as uint128_t so that a
+ * sweep with any Total type can be recorded.
+ *
+ * Only records for graphs swept or retained by this run are written back,
+ * so records left by runs over other inputs do not accumulate.
+ *
+ * Writes are rate limited to one per interval. Each write goes to a
+ * temporary file unique to the process, which is synced to disk before it
+ * is renamed over the checkpoint, so neither a crash nor a concurrent run
+ * can leave a partial file behind.
+ */
+class Checkpoint
+{
+public:
+    /**
+     * Constructs a Checkpoint backed by the file at path, loading any
+     * progress already recorded there. Progress is written at most once
+     * per interval.
+     */
+    Checkpoint(const std::string &path,
+               std::chrono::seconds interval = std::chrono::seconds(30));
+
+    /**
+     * Looks up the progress recorded for the graph with the given hash and
+     * number of sources. Sets sourcesDone and partialSum and returns true if
+     * a matching record exists. Otherwise, leaves them unchanged and returns
+     * false.
+     */
+    bool resume(std::uint64_t graphHash, std::size_t numSources,
+                std::size_t &sourcesDone, uint128_t &partialSum) const;
+
+    /**
+     * Records the progress of the sweep over the graph with the given hash.
+     * Writes the file if the interval has passed since the last write, or
+     * if force is set.
+     */
+    void update(std::uint64_t graphHash, std::size_t numSources,
+                std::size_t sourcesDone, uint128_t partialSum,
+                bool force = false);
+
+    /**
+     * Marks the graph with the given hash as part of this run, so any
+     * progress recorded for it is kept when the file is next written.
+     */
+    void retain(std::uint64_t graphHash);
+
+private:
+    /**
+     * Progress of a single sweep.
+     */
+    struct Record {
+        std::size_t numSources;
+        std::size_t sourcesDone;
+        uint128_t partialSum;
+    };
+
+    /**
+     * Writes all records to the file. Returns false if the file could
+     * not be written.
+     */
+    bool save();
+
+    /**
+     * Path of the checkpoint file.
+     */
+    std::string path;
+
+    /**
+     * Minimum time between writes.
+     */
+    std::chrono::seconds interval;
+
+    /**
+     * Time of the last write.
+     */
+    std::chrono::steady_clock::time_point lastSave;
+
+    /**
+     * Whether a failed write has already been reported.
+     */
+    bool reportedFailure;
+
+    /**
+     * Map of graph hash to the progress of its sweep.
+     */
+    std::map<std::uint64_t, Record> records;
+
+    /**
+     * Hashes of the graphs that belong to this run. Only their records
+     * are written.
+     */
+    std::set<std::uint64_t> retained;
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "DeltaStepping.hpp"
+#include "Weights.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <system_error>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Constructs a DeltaStepping engine over a graph with the given
+ * adjacency. The edges of Vertex v are targets[offsets[v]] through
+ * targets[offsets[v + 1] - 1], with matching lengths.
+ *
+ * Takes ownership of the arrays rather than copying them, since they
+ * are as large as the graph.
+ *
+ * If delta is 0, it is chosen from the distribution of edge lengths.
+ * If the system cannot start as many threads as requested, the engine
+ * runs with those it could start.
+ */
+template <typename Weight, typename Total>
+DeltaStepping<Weight, Total>::DeltaStepping(vector<unsigned int> &&offsets,
+                                            vector<unsigned int> &&targets,
+                                            vector<Weight> &&lengths,
+                                            unsigned int delta, unsigned int threads)
+{
+    this->offsets = std::move(offsets);
+    this->targets = std::move(targets);
+    this->lengths = std::move(lengths);
+    this->numVertices = this->offsets.size() - 1;
+    this->threads = max(1u, threads);
+    this->parallelThreshold = DELTA_STEPPING_MIN_PARALLEL_FRONTIER;
+
+    if (delta == 0) {
+        // Meyer and Sanders suggest delta = max length / degree for random
+        // lengths. Twice the mean is used in place of the max so that a few
+        // very long edges don't inflate the buckets.
+        double totalLength = 0;
+        for (auto length : this->lengths) {
+            totalLength += length;
+        }
+        double averageDegree = static_cast<double>(this->targets.size()) / max(1u, numVertices);
+        double meanLength = totalLength / max<size_t>(1, this->lengths.size());
+        delta = static_cast<unsigned int>(2 * meanLength / max(1.0, averageDegree));
+    }
+    this->delta = max(1u, delta);
+
+    // Move each Vertex's light edges before its heavy edges, in place
+    lightEnds.resize(numVertices);
+    for (unsigned int v = 0; v < numVertices; v++) {
+        unsigned int light = this->offsets[v];
+        for (unsigned int e = this->offsets[v]; e < this->offsets[v + 1]; e++) {
+            if (this->lengths[e] <= this->delta) {
+                swap(this->targets[light], this->targets[e]);
+                swap(this->lengths[light], this->lengths[e]);
+                light++;
+            }
+        }
+        lightEnds[v] = light;
+    }
+
+    distances.reset(new atomic<uint64_t>[numVertices]);
+    lastPhase.resize(numVertices);
+    lastBucket.resize(numVertices);
+
+    // Start the workers once; each relax() hands them a new job
+    jobFrontier = nullptr;
+    jobLight = false;
+    jobNumber = 0;
+    jobsRunning = 0;
+    stopping = false;
+    improved.resize(this->threads);
+    for (auto &state : improved) {
+        state.lastNumber = 0;
+        state.last = nullptr;
+    }
+    for (unsigned int t = 1; t < this->threads; t++) {
+        try {
+            workers.push_back(thread(&DeltaStepping::work, this, t));
+        } catch (const system_error &error) {
+            // Workers only wait for jobs until one is posted, so it is
+            // safe to shrink the pool before any job exists
+            cerr << "Unable to start delta-stepping thread " << t << " of "
+                 << this->threads << ", continuing with " << t << ": "
+                 << error.what() << endl;
+            this->threads = t;
+            improved.resize(t);
+            break;
+        }
+    }
+}
+
+/**
+ * Stops and joins the worker threads.
+ */
+template <typename Weight, typename Total>
+DeltaStepping<Weight, Total>::~DeltaStepping()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    jobPosted.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Returns the bucket width used by this engine.
+ */
+template <typename Weight, typename Total>
+unsigned int DeltaStepping<Weight, Total>::getDelta() const
+{
+    return delta;
+}
+
+/**
+ * Returns the number of threads used to relax edges, including the
+ * calling thread.
+ */
+template <typename Weight, typename Total>
+unsigned int DeltaStepping<Weight, Total>::getThreads() const
+{
+    return threads;
+}
+
+/**
+ * Sets the size of the smallest frontier that is split across
+ * threads. 0 or 1 splits every frontier.
+ */
+template <typename Weight, typename Total>
+void DeltaStepping<Weight, Total>::setParallelThreshold(size_t minFrontier)
+{
+    parallelThreshold = minFrontier;
+}
+
+/**
+ * Determines the combined distance from the Vertex with the given index
+ * to all other Vertices.
+ *
+ * Returns max possible distance if any Vertex is unreachable, as with
+ * UndirectedGraph::totalDistance.
+ */
+template <typename Weight, typename Total>
+Total DeltaStepping<Weight, Total>::totalDistance(unsigned int source)
+{
+    for (unsigned int v = 0; v < numVertices; v++) {
+        distances[v].store(std::numeric_limits<uint64_t>::max(), memory_order_relaxed);
+    }
+    fill(lastPhase.begin(), lastPhase.end(), 0);
+    fill(lastBucket.begin(), lastBucket.end(), 0);
+    buckets.clear();
+
+    distances[source].store(0, memory_order_relaxed);
+    buckets[0].push_back(source);
+
+    unsigned int phase = 0;
+    vector<unsigned int> frontier;
+    vector<unsigned int> settled;
+    // Relaxations never file a Vertex below the current bucket, so the
+    // first bucket in the map is always the next one to settle
+    while (!buckets.empty()) {
+        uint64_t i = buckets.begin()->first;
+        settled.clear();
+        // Light edges can refill the current bucket, so repeat until empty
+        while (!buckets.empty() && buckets.begin()->first == i) {
+            phase++;
+            frontier.clear();
+            for (auto v : buckets.begin()->second) {
+                // Skip entries that moved to a lower bucket or were
+                // already taken in this phase
+                if (distances[v].load(memory_order_relaxed) / delta != i ||
+                    lastPhase[v] == phase) {
+                    continue;
+                }
+                lastPhase[v] = phase;
+                frontier.push_back(v);
+                if (lastBucket[v] != i + 1) {
+                    lastBucket[v] = i + 1;
+                    settled.push_back(v);
+                }
+            }
+            buckets.erase(buckets.begin());
+            relax(frontier, true);
+        }
+        // Heavy edges always land in a later bucket, so relax them once
+        relax(settled, false);
+    }
+
+    Total totalDistance = 0;
+    for (unsigned int v = 0; v < numVertices; v++) {
+        uint64_t distance = distances[v].load(memory_order_relaxed);
+        if (distance == std::numeric_limits<uint64_t>::max()) {
+            return maxTotal<Total>();
+        }
+        totalDistance += distance;
+    }
+    return totalDistance;
+}
+
+/**
+ * Relaxes either the light or the heavy edges of every Vertex in
+ * frontier, then merges each thread's improved Vertices into buckets.
+ */
+template <typename Weight, typename Total>
+void DeltaStepping<Weight, Total>::relax(const vector<unsigned int> &frontier, bool light)
+{
+    if (workers.empty() || frontier.size() < parallelThreshold) {
+        // Chunk 0 of a single thread is the whole frontier
+        for (size_t i = 0; i < frontier.size(); i++) {
+            relaxVertex(frontier[i], light, 0);
+        }
+    } else {
+        {
+            lock_guard<mutex> guard(lock);
+            jobFrontier = &frontier;
+            jobLight = light;
+            jobsRunning = workers.size();
+            jobNumber++;
+        }
+        jobPosted.notify_all();
+        relaxChunk(frontier, light, 0);
+        unique_lock<mutex> guard(lock);
+        jobDone.wait(guard, [&]() { return jobsRunning == 0; });
+    }
+
+    // Each thread filed its Vertices by the distance it set. A Vertex
+    // improved again by another thread also sits in its lower bucket, and
+    // the entry in the higher one is skipped as stale when it comes up.
+    for (auto &state : improved) {
+        for (auto &bucket : state.buckets) {
+            vector<unsigned int> &merged = buckets[bucket.first];
+            if (merged.empty()) {
+                merged.swap(bucket.second);
+            } else {
+                merged.insert(merged.end(), bucket.second.begin(), bucket.second.end());
+            }
+        }
+        state.buckets.clear();
+        state.last = nullptr;
+    }
+}
+
+/**
+ * Relaxes the edges of the given thread's share of frontier. The
+ * share is one of `threads` equal, consecutive chunks.
+ */
+template <typename Weight, typename Total>
+void DeltaStepping<Weight, Total>::relaxChunk(const vector<unsigned int> &frontier,
+                                              bool light, unsigned int thread)
+{
+    size_t chunk = (frontier.size() + threads - 1) / threads;
+    size_t begin = min(frontier.size(), thread * chunk);
+    size_t end = min(frontier.size(), begin + chunk);
+    for (size_t i = begin; i < end; i++) {
+        relaxVertex(frontier[i], light, thread);
+    }
+}
+
+/**
+ * Relaxes either the light or the heavy edges of a single Vertex,
+ * filing improved Vertices into the given thread's buckets.
+ */
+template <typename Weight, typename Total>
+void DeltaStepping<Weight, Total>::relaxVertex(unsigned int from, bool light,
+                                               unsigned int thread)
+{
+    ThreadBuckets &state = improved[thread];
+    uint64_t fromDistance = distances[from].load(memory_order_relaxed);
+    unsigned int first = light ? offsets[from] : lightEnds[from];
+    unsigned int last = light ? lightEnds[from] : offsets[from + 1];
+    for (unsigned int e = first; e < last; e++) {
+        uint64_t newLength = fromDistance + lengths[e];
+        uint64_t current = distances[targets[e]].load(memory_order_relaxed);
+        // Atomic minimum; only the winning thread records the update
+        while (newLength < current) {
+            if (distances[targets[e]].compare_exchange_weak(current, newLength,
+                    memory_order_relaxed)) {
+                uint64_t number = newLength / delta;
+                if (!state.last || state.lastNumber != number) {
+                    state.lastNumber = number;
+                    state.last = &state.buckets[number];
+                }
+                state.last->push_back(targets[e]);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Body of each worker thread. Waits for relax() to post a frontier,
+ * relaxes its chunk, and reports back.
+ */
+template <typename Weight, typename Total>
+void DeltaStepping<Weight, Total>::work(unsigned int thread)
+{
+    uint64_t lastJob = 0;
+    while (true) {
+        unique_lock<mutex> guard(lock);
+        jobPosted.wait(guard, [&]() { return stopping || jobNumber != lastJob; });
+        if (stopping) {
+            return;
+        }
+        lastJob = jobNumber;
+        const vector<unsigned int> &frontier = *jobFrontier;
+        bool light = jobLight;
+        guard.unlock();
+
+        relaxChunk(frontier, light, thread);
+
+        guard.lock();
+        if (--jobsRunning == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+// Instantiate every pairing listed in Weights.hpp
+template class DeltaStepping<uint16_t, uint64_t>;
+template class DeltaStepping<uint16_t, uint128_t>;
+template class DeltaStepping<uint32_t, uint64_t>;
+template class DeltaStepping<uint32_t, uint128_t>;
@@ -0,0 +1,247 @@
+#ifndef DELTASTEPPING_HPP
+#define DELTASTEPPING_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Default size of the smallest frontier that is split across threads.
+ * Smaller frontiers are relaxed on the calling thread alone, since waking
+ * the workers and waiting for them costs far more than relaxing a few
+ * vertices.
+ */
+const size_t DELTA_STEPPING_MIN_PARALLEL_FRONTIER = 4096;
+
+/**
+ * Parallel single-source shortest paths using Meyer and Sanders'
+ * delta-stepping algorithm.
+ *
+ * Operates on a compact snapshot of a graph in compressed sparse row form,
+ * where Vertices are identified by their index. Tentative distances are
+ * kept in buckets of width delta. Each bucket is settled by repeatedly
+ * relaxing the light edges (length <= delta) of its members, then relaxing
+ * their heavy edges once. Both kinds of relaxation are split across a pool
+ * of worker threads that lives as long as the engine.
+ *
+ * Edge lengths are of type Weight, so narrow weights keep the adjacency
+ * arrays compact. Any single distance fits in 64 bits; sums of distances
+ * are of type Total.
+ */
+template <typename Weight, typename Total>
+class DeltaStepping
+{
+public:
+    /**
+     * Constructs a DeltaStepping engine over a graph with the given
+     * adjacency. The edges of Vertex v are targets[offsets[v]] through
+     * targets[offsets[v + 1] - 1], with matching lengths.
+     *
+     * Takes ownership of the arrays rather than copying them, since they
+     * are as large as the graph.
+     *
+     * If delta is 0, it is chosen from the distribution of edge lengths.
+     * If the system cannot start as many threads as requested, the engine
+     * runs with those it could start.
+     */
+    DeltaStepping(std::vector<unsigned int> &&offsets,
+                  std::vector<unsigned int> &&targets,
+                  std::vector<Weight> &&lengths,
+                  unsigned int delta, unsigned int threads);
+
+    /**
+     * Stops and joins the worker threads.
+     */
+    ~DeltaStepping();
+
+    /**
+     * Returns the bucket width used by this engine.
+     */
+    unsigned int getDelta() const;
+
+    /**
+     * Returns the number of threads used to relax edges, including the
+     * calling thread.
+     */
+    unsigned int getThreads() const;
+
+    /**
+     * Sets the size of the smallest frontier that is split across
+     * threads. 0 or 1 splits every frontier.
+     */
+    void setParallelThreshold(size_t minFrontier);
+
+    /**
+     * Determines the combined distance from the Vertex with the given index
+     * to all other Vertices.
+     *
+     * Returns max possible distance if any Vertex is unreachable, as with
+     * UndirectedGraph::totalDistance.
+     */
+    Total totalDistance(unsigned int source);
+
+private:
+    /**
+     * Vertices improved by one thread during a relaxation, filed by their
+     * new bucket number. Padded so that no two threads write to the same
+     * cache line.
+     */
+    struct ThreadBuckets {
+        /**
+         * Map of bucket number to the Vertices this thread filed there.
+         */
+        std::map<std::uint64_t, std::vector<unsigned int>> buckets;
+
+        /**
+         * Number and contents of the bucket filed into last, so runs of
+         * Vertices landing in the same bucket skip the map lookup.
+         */
+        std::uint64_t lastNumber;
+        std::vector<unsigned int> *last;
+
+        char padding[64];
+    };
+
+    /**
+     * Relaxes either the light or the heavy edges of every Vertex in
+     * frontier, then merges each thread's improved Vertices into buckets.
+     */
+    void relax(const std::vector<unsigned int> &frontier, bool light);
+
+    /**
+     * Relaxes the edges of the given thread's share of frontier. The
+     * share is one of `threads` equal, consecutive chunks.
+     */
+    void relaxChunk(const std::vector<unsigned int> &frontier, bool light,
+                    unsigned int thread);
+
+    /**
+     * Relaxes either the light or the heavy edges of a single Vertex,
+     * filing improved Vertices into the given thread's buckets.
+     */
+    void relaxVertex(unsigned int from, bool light, unsigned int thread);
+
+    /**
+     * Body of each worker thread. Waits for relax() to post a frontier,
+     * relaxes its chunk, and reports back.
+     */
+    void work(unsigned int thread);
+
+    /**
+     * Number of Vertices in the graph.
+     */
+    unsigned int numVertices;
+
+    /**
+     * Start of each Vertex's edges, plus one past the last edge.
+     */
+    std::vector<unsigned int> offsets;
+
+    /**
+     * End of each Vertex's light edges. Edges are sorted so the light edges
+     * of a Vertex come before its heavy edges.
+     */
+    std::vector<unsigned int> lightEnds;
+
+    /**
+     * Target Vertex of each edge.
+     */
+    std::vector<unsigned int> targets;
+
+    /**
+     * Length of each edge.
+     */
+    std::vector<Weight> lengths;
+
+    /**
+     * Bucket width.
+     */
+    unsigned int delta;
+
+    /**
+     * Number of threads used to relax edges.
+     */
+    unsigned int threads;
+
+    /**
+     * Frontiers with fewer Vertices than this are relaxed on the calling
+     * thread alone.
+     */
+    size_t parallelThreshold;
+
+    /**
+     * Tentative distance of each Vertex from the source.
+     */
+    std::unique_ptr<std::atomic<std::uint64_t>[]> distances;
+
+    /**
+     * Map of bucket number (tentative distance / delta) to the Vertices in
+     * that bucket. Only non-empty buckets are present, so long edges never
+     * leave runs of empty buckets to allocate and scan. May hold stale
+     * entries for Vertices whose distance has since decreased.
+     */
+    std::map<std::uint64_t, std::vector<unsigned int>> buckets;
+
+    /**
+     * Vertices whose distance improved during a relaxation, per thread.
+     */
+    std::vector<ThreadBuckets> improved;
+
+    /**
+     * Last phase and bucket each Vertex was taken from, used to drop
+     * duplicate entries.
+     */
+    std::vector<unsigned int> lastPhase;
+    std::vector<std::uint64_t> lastBucket;
+
+    /**
+     * Worker threads, numbered 1 to threads - 1. The thread calling
+     * relax() handles chunk 0 itself.
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * Guards the job fields below.
+     */
+    std::mutex lock;
+
+    /**
+     * Signalled when a new job is posted or the workers should stop.
+     */
+    std::condition_variable jobPosted;
+
+    /**
+     * Signalled when the last worker finishes the current job.
+     */
+    std::condition_variable jobDone;
+
+    /**
+     * Frontier and edge kind of the current job.
+     */
+    const std::vector<unsigned int> *jobFrontier;
+    bool jobLight;
+
+    /**
+     * Incremented for every posted job, so workers can tell a new job
+     * from the one they just finished.
+     */
+    std::uint64_t jobNumber;
+
+    /**
+     * Number of workers still relaxing the current job.
+     */
+    unsigned int jobsRunning;
+
+    /**
+     * Set when the engine is destroyed.
+     */
+    bool stopping;
+};
+
+#endif
@@ -1,9 +1,12 @@
 #include "Edge.hpp"
 #include "Vertex.hpp"
+#include "Weights.hpp"
+#include <cstdint>
 #include <unordered_map>
 
-Edge::Edge(Vertex *from, Vertex *to, unsigned int cost,
-           unsigned int length)
+template <typename Weight, typename Total>
+Edge<Weight, Total>::Edge(Vertex<Weight, Total> *from, Vertex<Weight, Total> *to,
+                          Weight cost, Weight length)
 {
     this->from = from;
     this->to = to;
@@ -11,36 +14,43 @@ Edge::Edge(Vertex *from, Vertex *to, unsigned int cost,
     this->length = length;
 }
 
-Vertex *Edge::getFrom() const
+template <typename Weight, typename Total>
+Vertex<Weight, Total> *Edge<Weight, Total>::getFrom() const
 {
     return from;
 }
-Vertex *Edge::getTo() const
+template <typename Weight, typename Total>
+Vertex<Weight, Total> *Edge<Weight, Total>::getTo() const
 {
     return to;
 }
 
-void Edge::setCost(unsigned int cost)
+template <typename Weight, typename Total>
+void Edge<Weight, Total>::setCost(Weight cost)
 {
     this->cost = cost;
 }
 
-unsigned int Edge::getCost() const
+template <typename Weight, typename Total>
+Weight Edge<Weight, Total>::getCost() const
 {
     return cost;
 }
 
-void Edge::setLength(unsigned int length)
+template <typename Weight, typename Total>
+void Edge<Weight, Total>::setLength(Weight length)
 {
     this->length = length;
 }
 
-unsigned int Edge::getLength() const
+template <typename Weight, typename Total>
+Weight Edge<Weight, Total>::getLength() const
 {
     return length;
 }
 
-bool Edge::operator<(const Edge &right) const
+template <typename Weight, typename Total>
+bool Edge<Weight, Total>::operator<(const Edge &right) const
 {
     // Deterministic way to deal with ties
     if(this->cost == right.cost)
@@ -49,3 +59,9 @@ bool Edge::operator<(const Edge &right) const
     }
     return ((this->cost) > right.cost);
 }
+
+// Instantiate every pairing listed in Weights.hpp
+template class Edge<uint16_t, uint64_t>;
+template class Edge<uint16_t, uint128_t>;
+template class Edge<uint32_t, uint64_t>;
+template class Edge<uint32_t, uint128_t>;
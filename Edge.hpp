@@ -2,6 +2,7 @@
 #define EDGE_HPP
 #include <unordered_map>
 
+template <typename Weight, typename Total>
 class Vertex;
 
 /**
@@ -9,19 +10,20 @@ class Vertex;
  *
  * Maintains pointers to the vertices that the edge originates
  * from and terminates at. Edges have both a cost and a length,
- * which are both non-negative integers.
+ * which are both non-negative integers of type Weight.
  *
  * Follows value semantics, so can be copy constructed.
  */
+template <typename Weight, typename Total>
 class Edge
 {
 public:
     /**
      * Constructs an Edge from the given parameters.
      */
-    Edge(Vertex *from, Vertex *to,
-         unsigned int cost,
-         unsigned int length);
+    Edge(Vertex<Weight, Total> *from, Vertex<Weight, Total> *to,
+         Weight cost,
+         Weight length);
 
     Edge() {}
 
@@ -29,33 +31,33 @@ public:
      * Returns a pointer to the Vertex that this Edge originates
      * from.
      */
-    Vertex *getFrom() const;
+    Vertex<Weight, Total> *getFrom() const;
 
     /**
      * Returns a pointer to the Vertex that this Edge terminates
      * at.
      */
-    Vertex *getTo() const;
+    Vertex<Weight, Total> *getTo() const;
 
     /**
      * Sets the cost of this Edge.
      */
-    void setCost(unsigned int cost);
+    void setCost(Weight cost);
 
     /**
      * Returns the cost of this Edge.
      */
-    unsigned int getCost() const;
+    Weight getCost() const;
 
     /**
      * Sets the length of this Edge.
      */
-    void setLength(unsigned int length);
+    void setLength(Weight length);
 
     /**
      * Returns the length of this Edge.
      */
-    unsigned int getLength() const;
+    Weight getLength() const;
 
     /*
      * Compares this Edge to another Edge. Suitable for
@@ -71,22 +73,22 @@ private:
     /**
      * Vertex that this Edge originates from.
      */
-    Vertex *from;
+    Vertex<Weight, Total> *from;
 
     /**
      * Vertex that this Edge terminates at.
      */
-    Vertex *to;
+    Vertex<Weight, Total> *to;
 
     /**
      * Cost of this Edge.
      */
-    unsigned int cost;
+    Weight cost;
 
     /**
      * Length of this Edge.
      */
-    unsigned int length;
+    Weight length;
 };
 
 #endif
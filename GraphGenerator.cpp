@@ -0,0 +1,441 @@
+#include "GraphGenerator.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+/**
+ * Target number of edges formatted per block. Large enough to amortize
+ * thread hand-off, small enough to keep the in-flight buffers modest.
+ */
+const uint64_t EDGES_PER_BLOCK = 1 << 18;
+
+/**
+ * Vertices drawing at most this many targets check for duplicates by
+ * scanning the targets drawn so far. Above it, a hash set keeps the
+ * check constant time.
+ */
+const uint64_t MAX_SCANNED_TARGETS = 32;
+
+/**
+ * Finalizer from SplitMix64. Cheap and well mixed, which is all we need
+ * for stateless per-vertex random streams.
+ */
+uint64_t mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Appends the decimal representation of value to buffer.
+ */
+void appendNumber(vector<char> &buffer, uint64_t value)
+{
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        buffer.push_back(digits[--count]);
+    }
+}
+}
+
+/**
+ * Constructs a generator for the given family. For GRID and TORUS,
+ * `size` is the number of rows and `param` the number of columns. For
+ * SPARSE and POWERLAW, `size` is the number of vertices and `param` the
+ * number of edges each vertex adds. For COMPLETE, `param` is ignored.
+ *
+ * Throws std::invalid_argument if the parameters cannot produce a
+ * valid graph.
+ */
+GraphGenerator::GraphGenerator(Family family, uint64_t size, uint64_t param,
+                               uint64_t seed, unsigned int maxLength)
+{
+    this->family = family;
+    this->size = size;
+    this->param = param;
+    this->seed = mix(seed);
+    this->maxLength = maxLength;
+
+    if (maxLength == 0) {
+        throw invalid_argument("max_length must be >= 1");
+    }
+    // Keep the products below from overflowing before we range check them
+    if (size > 0x7fffffffULL || param > 0x7fffffffULL) {
+        throw invalid_argument("graph is too large");
+    }
+    switch (family) {
+    case SPARSE:
+    case POWERLAW:
+        if (size < 2) {
+            throw invalid_argument("num_vertices must be >= 2");
+        }
+        if (param < 1) {
+            throw invalid_argument("degree must be >= 1");
+        }
+        numSlots = firstSlot(size);
+        break;
+    case COMPLETE:
+        if (size < 2) {
+            throw invalid_argument("num_vertices must be >= 2");
+        }
+        numSlots = firstSlot(size);
+        break;
+    case GRID:
+        if (size * param < 2) {
+            throw invalid_argument("grid must have at least 2 vertices");
+        }
+        numSlots = 2 * size * param;
+        break;
+    case TORUS:
+        // Smaller tori would wrap onto an existing edge
+        if (size < 3 || param < 3) {
+            throw invalid_argument("torus rows and cols must be >= 3");
+        }
+        numSlots = 2 * size * param;
+        break;
+    }
+    // netplan reads costs as unsigned int
+    if (numSlots > static_cast<uint64_t>(numeric_limits<unsigned int>::max()) + 1) {
+        throw invalid_argument("graph has too many edges for 32-bit costs");
+    }
+    permBits = 2;
+    while ((1ULL << permBits) < numSlots) {
+        permBits += 2;
+    }
+}
+
+/**
+ * Returns the number of vertices in the generated graph.
+ */
+uint64_t GraphGenerator::numVertices() const
+{
+    if (family == GRID || family == TORUS) {
+        return size * param;
+    }
+    return size;
+}
+
+/**
+ * Returns the number of edges in the generated graph.
+ */
+uint64_t GraphGenerator::numEdges() const
+{
+    if (family == GRID) {
+        // Every row has cols - 1 edges, every column has rows - 1 edges
+        return size * (param - 1) + param * (size - 1);
+    }
+    // Slots are dense for every other family
+    return numSlots;
+}
+
+/**
+ * Returns the number of edges owned by vertex v.
+ */
+uint64_t GraphGenerator::ownedEdges(uint64_t v) const
+{
+    switch (family) {
+    case SPARSE:
+    case POWERLAW:
+        // Each vertex connects to vertices with a smaller index only
+        return min(v, param);
+    case COMPLETE:
+        return size - 1 - v;
+    case GRID: {
+        uint64_t row = v / param;
+        uint64_t col = v % param;
+        return (col + 1 < param ? 1 : 0) + (row + 1 < size ? 1 : 0);
+    }
+    case TORUS:
+        return 2;
+    }
+    return 0;
+}
+
+/**
+ * Returns the index of the first cost slot of vertex v. Slots are
+ * permuted into costs, so distinct slots yield distinct costs.
+ */
+uint64_t GraphGenerator::firstSlot(uint64_t v) const
+{
+    switch (family) {
+    case SPARSE:
+    case POWERLAW:
+        // Sum of min(u, degree) for all u < v
+        if (v <= param) {
+            return v * (v - (v > 0 ? 1 : 0)) / 2;
+        }
+        return param * (param - 1) / 2 + (v - param) * param;
+    case COMPLETE:
+        // Sum of (size - 1 - u) for all u < v
+        return v * (size - 1) - v * (v - (v > 0 ? 1 : 0)) / 2;
+    case GRID:
+    case TORUS:
+        // One slot for the right edge, one for the down edge
+        return 2 * v;
+    }
+    return 0;
+}
+
+/**
+ * Writes the whole graph to out using the given number of threads.
+ * Uses no more threads than there are blocks of edges to format, and
+ * continues with fewer if the system cannot start them all.
+ *
+ * Returns false if writing to out failed.
+ */
+bool GraphGenerator::write(FILE *out, unsigned int threads) const
+{
+    uint64_t vertices = numVertices();
+    uint64_t averageDegree = max<uint64_t>(1, numEdges() / vertices);
+    uint64_t blockVertices = max<uint64_t>(1, EDGES_PER_BLOCK / averageDegree);
+    uint64_t numBlocks = (vertices + blockVertices - 1) / blockVertices;
+    // Workers beyond one per block would never get any work
+    threads = static_cast<unsigned int>(min<uint64_t>(threads, numBlocks));
+
+    if (threads <= 1) {
+        vector<char> buffer;
+        for (uint64_t block = 0; block < numBlocks; block++) {
+            buffer.clear();
+            formatBlock(block * blockVertices,
+                        min(vertices, (block + 1) * blockVertices), buffer);
+            if (fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+                return false;
+            }
+        }
+        return fflush(out) == 0;
+    }
+
+    // Workers claim blocks in order and format them into a ring of buffers.
+    // This thread writes the ring out in block order, so a worker may only
+    // run `window` blocks ahead of the writer.
+    uint64_t window = 2 * threads;
+    vector<vector<char>> buffers(window);
+    vector<bool> ready(window, false);
+    uint64_t nextBlock = 0;
+    uint64_t written = 0;
+    bool failed = false;
+    mutex lock;
+    condition_variable changed;
+
+    auto worker = [&]() {
+        while (true) {
+            unique_lock<mutex> guard(lock);
+            uint64_t block = nextBlock++;
+            if (block >= numBlocks) {
+                return;
+            }
+            changed.wait(guard, [&]() {
+                return failed || block < written + window;
+            });
+            if (failed) {
+                return;
+            }
+            guard.unlock();
+
+            vector<char> &buffer = buffers[block % window];
+            buffer.clear();
+            formatBlock(block * blockVertices,
+                        min(vertices, (block + 1) * blockVertices), buffer);
+
+            guard.lock();
+            ready[block % window] = true;
+            changed.notify_all();
+        }
+    };
+
+    // Hold the lock while starting the workers, so none claims a block
+    // before the ring is sized for the workers that actually started
+    vector<thread> workers;
+    unique_lock<mutex> starting(lock);
+    try {
+        for (unsigned int i = 0; i < threads; i++) {
+            workers.push_back(thread(worker));
+        }
+    } catch (const system_error &error) {
+        // Workers claim blocks as they go, so any number of them can
+        // finish the job. Without any, format on this thread instead.
+        cerr << "Unable to start generator thread " << workers.size() + 1
+             << " of " << threads << ", continuing with " << workers.size()
+             << ": " << error.what() << endl;
+        if (workers.empty()) {
+            starting.unlock();
+            return write(out, 1);
+        }
+        window = 2 * workers.size();
+        buffers.resize(window);
+        ready.assign(window, false);
+    }
+    starting.unlock();
+    for (uint64_t block = 0; block < numBlocks && !failed; block++) {
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [&]() { return bool(ready[block % window]); });
+        guard.unlock();
+
+        vector<char> &buffer = buffers[block % window];
+        bool ok = fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+
+        guard.lock();
+        ready[block % window] = false;
+        written++;
+        failed = !ok;
+        changed.notify_all();
+    }
+    for (auto &currentWorker : workers) {
+        currentWorker.join();
+    }
+    return !failed && fflush(out) == 0;
+}
+
+/**
+ * Appends all edges owned by vertices [begin, end) to buffer.
+ */
+void GraphGenerator::formatBlock(uint64_t begin, uint64_t end,
+                                 vector<char> &buffer) const
+{
+    vector<uint64_t> targets;
+    unordered_set<uint64_t> drawn;
+    // Records a newly drawn target. Returns false if it was drawn before.
+    auto addTarget = [&](uint64_t to) {
+        if (targets.size() < MAX_SCANNED_TARGETS) {
+            if (find(targets.begin(), targets.end(), to) != targets.end()) {
+                return false;
+            }
+        } else {
+            if (drawn.empty()) {
+                drawn.insert(targets.begin(), targets.end());
+            }
+            if (!drawn.insert(to).second) {
+                return false;
+            }
+        }
+        targets.push_back(to);
+        return true;
+    };
+    for (uint64_t v = begin; v < end; v++) {
+        uint64_t slot = firstSlot(v);
+        uint64_t count = ownedEdges(v);
+        switch (family) {
+        case SPARSE:
+        case POWERLAW:
+            targets.clear();
+            drawn.clear();
+            if (count == v) {
+                // Every smaller vertex is a target
+                for (uint64_t to = 0; to < v; to++) {
+                    targets.push_back(to);
+                }
+            } else if (family == SPARSE) {
+                // Floyd's algorithm draws count distinct targets uniformly
+                // with exactly count random numbers, however close count
+                // is to v
+                for (uint64_t j = v - count; j < v; j++) {
+                    if (!addTarget(random(v, j) % (j + 1))) {
+                        addTarget(j);
+                    }
+                }
+            } else {
+                // Draw distinct targets. The first one is always new, so
+                // every vertex is attached to the tree of smaller vertices.
+                for (uint64_t k = 0; targets.size() < count; k++) {
+                    // Squaring a uniform variate weights older vertices
+                    // like preferential attachment, giving P(deg) ~ deg^-3
+                    double u = (random(v, k) >> 11) * (1.0 / (1ULL << 53));
+                    addTarget(static_cast<uint64_t>(u * u * v));
+                }
+            }
+            for (uint64_t k = 0; k < count; k++) {
+                appendEdge(buffer, v, targets[k], slot + k);
+            }
+            break;
+        case COMPLETE:
+            for (uint64_t to = v + 1; to < size; to++) {
+                appendEdge(buffer, v, to, slot++);
+            }
+            break;
+        case GRID:
+        case TORUS: {
+            uint64_t row = v / param;
+            uint64_t col = v % param;
+            if (col + 1 < param) {
+                appendEdge(buffer, v, v + 1, slot);
+            } else if (family == TORUS) {
+                appendEdge(buffer, v, row * param, slot);
+            }
+            if (row + 1 < size) {
+                appendEdge(buffer, v, v + param, slot + 1);
+            } else if (family == TORUS) {
+                appendEdge(buffer, v, col, slot + 1);
+            }
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * Appends a single "from to cost length" line to buffer. The cost and
+ * length are both derived from the edge's cost slot.
+ */
+void GraphGenerator::appendEdge(vector<char> &buffer, uint64_t from,
+                                uint64_t to, uint64_t slot) const
+{
+    appendNumber(buffer, from);
+    buffer.push_back(' ');
+    appendNumber(buffer, to);
+    buffer.push_back(' ');
+    // Using unique costs guarantees a unique MST
+    appendNumber(buffer, permuteSlot(slot));
+    buffer.push_back(' ');
+    appendNumber(buffer, 1 + mix(seed ^ mix(~slot)) % maxLength);
+    buffer.push_back('\n');
+}
+
+/**
+ * Maps a cost slot to a cost. A seeded bijection on [0, numSlots), so
+ * every edge gets a distinct cost in that range.
+ */
+uint64_t GraphGenerator::permuteSlot(uint64_t slot) const
+{
+    // Four round Feistel network over permBits bits, cycle walking until
+    // the result lands back inside [0, numSlots)
+    unsigned int halfBits = permBits / 2;
+    uint64_t mask = (1ULL << halfBits) - 1;
+    do {
+        uint64_t left = slot >> halfBits;
+        uint64_t right = slot & mask;
+        for (uint64_t round = 0; round < 4; round++) {
+            uint64_t next = left ^ (mix(seed + round * 0x632be59bd9b4e019ULL + right) & mask);
+            left = right;
+            right = next;
+        }
+        slot = (left << halfBits) | right;
+    } while (slot >= numSlots);
+    return slot;
+}
+
+/**
+ * Returns the k-th pseudo-random number of vertex v. Stateless, so any
+ * vertex can be generated by any thread.
+ */
+uint64_t GraphGenerator::random(uint64_t v, uint64_t k) const
+{
+    return mix(mix(seed ^ v) + k);
+}
@@ -0,0 +1,138 @@
+#ifndef GRAPHGENERATOR_HPP
+#define GRAPHGENERATOR_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Generates synthetic netplan input files for scale testing.
+ *
+ * Like generator.py, every graph produced is guaranteed to:
+ * 1) Be connected.
+ * 2) Have a unique minimum spanning tree (all costs are distinct).
+ * 3) Not have duplicate edges.
+ *
+ * Vertices are named by their index. Every edge is owned by exactly one of
+ * its endpoints, so each vertex's edges can be produced independently of all
+ * others. Edges are formatted in blocks of consecutive vertices by a pool of
+ * worker threads and written to the output in order, so the same seed always
+ * produces the same file regardless of the number of threads.
+ */
+class GraphGenerator
+{
+public:
+    /**
+     * Supported topology families.
+     *
+     * SPARSE:   each vertex connects to `degree` distinct random vertices
+     *           with a smaller index (the first of which forms a random
+     *           spanning tree).
+     * COMPLETE: every pair of vertices is connected.
+     * GRID:     rows x cols lattice.
+     * TORUS:    rows x cols lattice with wrap-around edges.
+     * POWERLAW: like SPARSE, but targets are biased towards low indices,
+     *           giving a power-law degree distribution.
+     */
+    enum Family { SPARSE, COMPLETE, GRID, TORUS, POWERLAW };
+
+    /**
+     * Constructs a generator for the given family. For GRID and TORUS,
+     * `size` is the number of rows and `param` the number of columns. For
+     * SPARSE and POWERLAW, `size` is the number of vertices and `param` the
+     * number of edges each vertex adds. For COMPLETE, `param` is ignored.
+     *
+     * Throws std::invalid_argument if the parameters cannot produce a
+     * valid graph.
+     */
+    GraphGenerator(Family family, std::uint64_t size, std::uint64_t param,
+                   std::uint64_t seed, unsigned int maxLength);
+
+    /**
+     * Returns the number of vertices in the generated graph.
+     */
+    std::uint64_t numVertices() const;
+
+    /**
+     * Returns the number of edges in the generated graph.
+     */
+    std::uint64_t numEdges() const;
+
+    /**
+     * Writes the whole graph to out using the given number of threads.
+     * Uses no more threads than there are blocks of edges to format, and
+     * continues with fewer if the system cannot start them all.
+     *
+     * Returns false if writing to out failed.
+     */
+    bool write(std::FILE *out, unsigned int threads) const;
+
+private:
+    /**
+     * Returns the number of edges owned by vertex v.
+     */
+    std::uint64_t ownedEdges(std::uint64_t v) const;
+
+    /**
+     * Returns the index of the first cost slot of vertex v. Slots are
+     * permuted into costs, so distinct slots yield distinct costs.
+     */
+    std::uint64_t firstSlot(std::uint64_t v) const;
+
+    /**
+     * Appends all edges owned by vertices [begin, end) to buffer.
+     */
+    void formatBlock(std::uint64_t begin, std::uint64_t end,
+                     std::vector<char> &buffer) const;
+
+    /**
+     * Appends a single "from to cost length" line to buffer. The cost and
+     * length are both derived from the edge's cost slot.
+     */
+    void appendEdge(std::vector<char> &buffer, std::uint64_t from,
+                    std::uint64_t to, std::uint64_t slot) const;
+
+    /**
+     * Maps a cost slot to a cost. A seeded bijection on [0, numSlots), so
+     * every edge gets a distinct cost in that range.
+     */
+    std::uint64_t permuteSlot(std::uint64_t slot) const;
+
+    /**
+     * Returns the k-th pseudo-random number of vertex v. Stateless, so any
+     * vertex can be generated by any thread.
+     */
+    std::uint64_t random(std::uint64_t v, std::uint64_t k) const;
+
+    Family family;
+
+    /**
+     * Rows for GRID/TORUS, vertices otherwise.
+     */
+    std::uint64_t size;
+
+    /**
+     * Columns for GRID/TORUS, per-vertex degree for SPARSE/POWERLAW.
+     */
+    std::uint64_t param;
+
+    std::uint64_t seed;
+
+    /**
+     * Edge lengths are uniform in [1, maxLength].
+     */
+    unsigned int maxLength;
+
+    /**
+     * Size of the cost slot space. All costs are below this.
+     */
+    std::uint64_t numSlots;
+
+    /**
+     * Number of bits in the Feistel permutation domain (rounded up to even).
+     */
+    unsigned int permBits;
+};
+
+#endif
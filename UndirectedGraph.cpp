@@ -1,7 +1,11 @@
 #include "UndirectedGraph.hpp"
 #include "Edge.hpp"
 #include "Vertex.hpp"
+#include "Weights.hpp"
+#include <cstdint>
 #include <queue>
+#include <algorithm>
+#include <thread>
 #include <vector>
 #include <limits>
 #include <utility>
@@ -14,18 +18,28 @@ using namespace std;
 * Constructs an empty UndirectedGraph with no vertices and
 * no edges.
 */
-UndirectedGraph::UndirectedGraph() { }
+template <typename Weight, typename Total>
+UndirectedGraph<Weight, Total>::UndirectedGraph()
+{
+    deltaStepping = nullptr;
+    delta = 0;
+    deltaSteppingThreshold = DELTA_STEPPING_MIN_VERTICES;
+    threads = 0;
+    parallelThreshold = DELTA_STEPPING_MIN_PARALLEL_FRONTIER;
+}
 
 /**
  * Destructs an UndirectedGraph.
  */
-UndirectedGraph::~UndirectedGraph()
+template <typename Weight, typename Total>
+UndirectedGraph<Weight, Total>::~UndirectedGraph()
 {
     for (auto &currentVertex : vertices) {
         currentVertex.second->clearEdges();
         delete currentVertex.second;
     }
     vertices.clear();
+    delete deltaStepping;
 }
 
 /**
@@ -35,19 +49,24 @@ UndirectedGraph::~UndirectedGraph()
  *
  * If either of the named vertices does not exist, it is created.
  */
-void UndirectedGraph::addEdge(const std::string &from, const std::string &to,
-                              unsigned int cost, unsigned int length)
+template <typename Weight, typename Total>
+void UndirectedGraph<Weight, Total>::addEdge(const std::string &from, const std::string &to,
+                                             Weight cost, Weight length)
 {
     if (!(vertices[from])) { // The from Vertex does not exist, create a new one
-        Vertex *newFrom = new Vertex(from);
+        Vertex<Weight, Total> *newFrom = new Vertex<Weight, Total>(from);
         vertices[from] = newFrom;
     }
 
     if (!(vertices[to])) { // The to Vertex does not exist, create a new one
-        Vertex *newTo = new Vertex(to);
+        Vertex<Weight, Total> *newTo = new Vertex<Weight, Total>(to);
         vertices[to] = newTo;
     }
 
+    // The delta-stepping snapshot no longer matches the graph
+    delete deltaStepping;
+    deltaStepping = nullptr;
+
     // Add 2 edges to the graph, one going from->to and the other going to->from
     // Do this to simulate an undirected graph
     vertices[from]->addEdge(vertices[to], cost, length);
@@ -60,9 +79,10 @@ void UndirectedGraph::addEdge(const std::string &from, const std::string &to,
  * Since this graph is undirected, is calcualted as the cost
  * of all Edges terminating at all Vertices, divided by 2.
  */
-unsigned int UndirectedGraph::totalEdgeCost() const
+template <typename Weight, typename Total>
+Total UndirectedGraph<Weight, Total>::totalEdgeCost() const
 {
-    unsigned int total = 0;
+    Total total = 0;
     // Iterate through the adjacency list of each vertex in the graph and add
     // the sum of its edges to a total. Divide the total by 2 because the graph
     // is undirected
@@ -83,10 +103,11 @@ unsigned int UndirectedGraph::totalEdgeCost() const
  */
 
 // Prim - MST
-UndirectedGraph *UndirectedGraph::minSpanningTree()
+template <typename Weight, typename Total>
+UndirectedGraph<Weight, Total> *UndirectedGraph<Weight, Total>::minSpanningTree()
 {
     // Priority queue for the edges
-    priority_queue<Edge> neighborEdges;
+    priority_queue<Edge<Weight, Total>> neighborEdges;
     // This graph will be the MST
     UndirectedGraph *MST = new UndirectedGraph();
     // Set the visited field of all vertices to false
@@ -126,7 +147,8 @@ UndirectedGraph *UndirectedGraph::minSpanningTree()
 
 /**
  * Determines the combined distance from the given Vertex to all
- * other Vertices in the graph using Dijkstra's algorithm.
+ * other Vertices in the graph using Dijkstra's algorithm, or
+ * delta-stepping on large graphs.
  *
  * Returns max possible distance if the given Vertex does not appear
  * in the graph, or if any of the Vertices in the graph are not
@@ -135,22 +157,32 @@ UndirectedGraph *UndirectedGraph::minSpanningTree()
  */
 
 // Dijkstra - Shortest Path
-unsigned int UndirectedGraph::totalDistance(const std::string &from)
+template <typename Weight, typename Total>
+Total UndirectedGraph<Weight, Total>::totalDistance(const std::string &from)
 {
+    if (vertices.size() >= deltaSteppingThreshold) {
+        DeltaStepping<Weight, Total> *engine = getDeltaStepping();
+        auto found = vertices.find(from);
+        if (found == vertices.end() || found->second == nullptr) {
+            return maxTotal<Total>();
+        }
+        return engine->totalDistance(found->second->getIndex());
+    }
     if (vertices[from] == nullptr) {
-        return std::numeric_limits<unsigned int>::max();
+        return maxTotal<Total>();
     }
-    unsigned int maxDistance = 0;
-    priority_queue<pair<Vertex *, unsigned int>, vector<pair<Vertex *, unsigned int>>,
+    Total maxDistance = 0;
+    priority_queue<pair<Vertex<Weight, Total> *, uint64_t>,
+                   vector<pair<Vertex<Weight, Total> *, uint64_t>>,
                    DijkstraVertexComparator> lengths;
     // Set the visited field of all vertices to false
     for (auto &currentVert : vertices) {
         currentVert.second->setVisited(false);
-        currentVert.second->setDistance(std::numeric_limits<unsigned int>::max());
+        currentVert.second->setDistance(numeric_limits<uint64_t>::max());
     }
     vertices[from]->setDistance(0);
     // Enqueue the start vertex
-    lengths.push(make_pair(vertices[from], 0));
+    lengths.push(make_pair(vertices[from], uint64_t(0)));
     while (lengths.size() > 0) {
         // Dequeue a vertex from lengths
         auto curr = lengths.top();
@@ -164,7 +196,7 @@ unsigned int UndirectedGraph::totalDistance(const std::string &from)
                 // The next adjacent vertex was not visited
                 if (!(adjVertex.second.getTo()->wasVisited())) {
                     // Calculate the new distance to the current vertex in the adj. list
-                    unsigned int newLength = ((curr.first->getDistance()) + (adjVertex.second.getLength()));
+                    uint64_t newLength = ((curr.first->getDistance()) + (adjVertex.second.getLength()));
                     // The new distance is less than the vertex's current distance
                     if (newLength < (adjVertex.second.getTo()->getDistance())) {
                         adjVertex.second.getTo()->setDistance(newLength);
@@ -177,6 +209,10 @@ unsigned int UndirectedGraph::totalDistance(const std::string &from)
     }
     // Calculate the total distance of all shortest paths for this vertex
     for (auto &currVert : vertices) {
+        // An unreachable vertex would wrap the sum, so report it instead
+        if (currVert.second->getDistance() == numeric_limits<uint64_t>::max()) {
+            return maxTotal<Total>();
+        }
         maxDistance += currVert.second->getDistance();
     }
     return maxDistance;
@@ -188,19 +224,203 @@ unsigned int UndirectedGraph::totalDistance(const std::string &from)
  *
  * Returns max possible distance if the graph is not connected.
  */
-unsigned int UndirectedGraph::totalDistance()
+template <typename Weight, typename Total>
+Total UndirectedGraph<Weight, Total>::totalDistance()
 {
-    unsigned int totalDistance = 0;
+    Total totalDistance = 0;
+    // On large graphs, run delta-stepping from every vertex index in turn
+    if (vertices.size() >= deltaSteppingThreshold) {
+        DeltaStepping<Weight, Total> *engine = getDeltaStepping();
+        for (unsigned int source = 0; source < vertices.size(); source++) {
+            Total distance = engine->totalDistance(source);
+            if (distance == maxTotal<Total>()) {
+                return maxTotal<Total>();
+            }
+            totalDistance += distance;
+        }
+        return totalDistance;
+    }
     // Run Dijkstra's algorithm on all vertices in the graph
     for (auto &currentVertex : vertices) {
-        totalDistance += this->totalDistance(currentVertex.first);
+        Total distance = this->totalDistance(currentVertex.first);
+        // The graph is not connected
+        if (distance == maxTotal<Total>()) {
+            return maxTotal<Total>();
+        }
+        totalDistance += distance;
     }
     // Return the sum of all shortest paths
     return totalDistance;
 }
 
-bool UndirectedGraph::DijkstraVertexComparator::operator()(const std::pair<Vertex *, unsigned int> &left,
-        const std::pair<Vertex *, unsigned int> &right)
+/**
+ * Determines the combined distance from all Vertices to all other
+ * Vertices in the graph, recording progress in the given Checkpoint.
+ *
+ * Sources are visited in name order. If the Checkpoint already holds
+ * progress for this graph, the sweep resumes from there.
+ */
+template <typename Weight, typename Total>
+Total UndirectedGraph<Weight, Total>::totalDistance(Checkpoint *checkpoint)
+{
+    if (!checkpoint) {
+        return totalDistance();
+    }
+    // A fixed order lets "sources done" be stored as a simple count
+    vector<string> sources;
+    sources.reserve(vertices.size());
+    for (auto &currentVertex : vertices) {
+        sources.push_back(currentVertex.first);
+    }
+    sort(sources.begin(), sources.end());
+
+    uint64_t graphHash = hash();
+    size_t sourcesDone = 0;
+    uint128_t partialSum = 0;
+    checkpoint->resume(graphHash, sources.size(), sourcesDone, partialSum);
+    Total totalDistance = static_cast<Total>(partialSum);
+    for (size_t i = sourcesDone; i < sources.size(); i++) {
+        Total distance = this->totalDistance(sources[i]);
+        // The graph is not connected
+        if (distance == maxTotal<Total>()) {
+            return maxTotal<Total>();
+        }
+        totalDistance += distance;
+        checkpoint->update(graphHash, sources.size(), i + 1, totalDistance);
+    }
+    // Always record the finished sweep
+    checkpoint->update(graphHash, sources.size(), sources.size(), totalDistance, true);
+    return totalDistance;
+}
+
+/**
+ * Returns a hash of the graph's vertices and edges, independent of
+ * the order in which the edges were added.
+ */
+template <typename Weight, typename Total>
+uint64_t UndirectedGraph<Weight, Total>::hash() const
+{
+    // FNV-1a, so the hash of a name is the same in every build
+    auto hashName = [](const string &name) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c : name) {
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        }
+        return hash;
+    };
+    // SplitMix64 finalizer to spread each edge's fields over all bits
+    auto mix = [](uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    };
+    uint64_t total = mix(vertices.size());
+    // Summing the hashes of each Edge makes the order irrelevant
+    for (auto &currentVertex : vertices) {
+        uint64_t fromHash = hashName(currentVertex.first);
+        for (auto &adjVertex : currentVertex.second->getEdges()) {
+            uint64_t edgeHash = mix(fromHash ^ mix(hashName(adjVertex.first)));
+            edgeHash = mix(edgeHash ^ adjVertex.second.getCost());
+            edgeHash = mix(edgeHash ^ adjVertex.second.getLength());
+            total += edgeHash;
+        }
+    }
+    return total;
+}
+
+/**
+ * Sets the bucket width used by delta-stepping. If delta is 0 (the
+ * default), it is chosen from the distribution of edge lengths.
+ */
+template <typename Weight, typename Total>
+void UndirectedGraph<Weight, Total>::setDelta(unsigned int delta)
+{
+    this->delta = delta;
+    delete deltaStepping;
+    deltaStepping = nullptr;
+}
+
+/**
+ * Sets the minimum number of vertices for which shortest paths are
+ * found with delta-stepping rather than Dijkstra's algorithm.
+ */
+template <typename Weight, typename Total>
+void UndirectedGraph<Weight, Total>::setDeltaSteppingThreshold(size_t minVertices)
+{
+    deltaSteppingThreshold = minVertices;
+}
+
+/**
+ * Sets the number of threads used by delta-stepping. If threads is 0
+ * (the default), one thread is used per hardware thread.
+ */
+template <typename Weight, typename Total>
+void UndirectedGraph<Weight, Total>::setThreads(unsigned int threads)
+{
+    this->threads = threads;
+    delete deltaStepping;
+    deltaStepping = nullptr;
+}
+
+/**
+ * Sets the size of the smallest delta-stepping frontier that is split
+ * across threads.
+ */
+template <typename Weight, typename Total>
+void UndirectedGraph<Weight, Total>::setParallelThreshold(size_t minFrontier)
+{
+    parallelThreshold = minFrontier;
+    if (deltaStepping) {
+        deltaStepping->setParallelThreshold(minFrontier);
+    }
+}
+
+/**
+ * Returns the delta-stepping engine for this graph, building a
+ * snapshot of the graph's adjacency if it is out of date.
+ */
+template <typename Weight, typename Total>
+DeltaStepping<Weight, Total> *UndirectedGraph<Weight, Total>::getDeltaStepping()
+{
+    if (deltaStepping) {
+        return deltaStepping;
+    }
+    // Number the vertices in iteration order, and count the edges so the
+    // arrays below are allocated at their exact size
+    unsigned int index = 0;
+    size_t numEdges = 0;
+    for (auto &currentVertex : vertices) {
+        currentVertex.second->setIndex(index++);
+        numEdges += currentVertex.second->getEdges().size();
+    }
+    // Flatten each vertex's adjacency list into consecutive arrays
+    vector<unsigned int> offsets;
+    vector<unsigned int> targets;
+    vector<Weight> lengths;
+    offsets.reserve(vertices.size() + 1);
+    targets.reserve(numEdges);
+    lengths.reserve(numEdges);
+    for (auto &currentVertex : vertices) {
+        offsets.push_back(targets.size());
+        for (auto &adjVertex : currentVertex.second->getEdges()) {
+            targets.push_back(adjVertex.second.getTo()->getIndex());
+            lengths.push_back(adjVertex.second.getLength());
+        }
+    }
+    offsets.push_back(targets.size());
+    // The engine takes over the arrays rather than copying them
+    unsigned int engineThreads = threads ? threads : std::thread::hardware_concurrency();
+    deltaStepping = new DeltaStepping<Weight, Total>(std::move(offsets), std::move(targets),
+                                                     std::move(lengths), delta,
+                                                     engineThreads);
+    deltaStepping->setParallelThreshold(parallelThreshold);
+    return deltaStepping;
+}
+
+template <typename Weight, typename Total>
+bool UndirectedGraph<Weight, Total>::DijkstraVertexComparator::operator()(
+        const std::pair<Vertex<Weight, Total> *, uint64_t> &left,
+        const std::pair<Vertex<Weight, Total> *, uint64_t> &right)
 {
     // Deterministic way to deal with ties
     if (left.second == right.second) {
@@ -208,3 +428,9 @@ bool UndirectedGraph::DijkstraVertexComparator::operator()(const std::pair<Verte
     }
     return left.second > right.second;
 }
+
+// Instantiate every pairing listed in Weights.hpp
+template class UndirectedGraph<uint16_t, uint64_t>;
+template class UndirectedGraph<uint16_t, uint128_t>;
+template class UndirectedGraph<uint32_t, uint64_t>;
+template class UndirectedGraph<uint32_t, uint128_t>;
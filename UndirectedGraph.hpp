@@ -1,10 +1,21 @@
 #ifndef UNDIRECTEDGRAPH_HPP
 #define UNDIRECTEDGRAPH_HPP
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
 #include "Vertex.hpp"
+#include "DeltaStepping.hpp"
+#include "Checkpoint.hpp"
+#include "Weights.hpp"
+
+/**
+ * Default number of vertices at which delta-stepping takes over from
+ * Dijkstra's algorithm. Below this, a single source is too cheap to be
+ * worth splitting across threads.
+ */
+const size_t DELTA_STEPPING_MIN_VERTICES = 1 << 16;
 
 /**
  * Implements an undirected graph. Any edge in the graph
@@ -13,7 +24,16 @@
  * Implements methods for producing a minimum spanning tree of the
  * graph, as well as calculating the total length of the shortest
  * paths between each pair of vertices.
+ *
+ * Shortest paths are found with Dijkstra's algorithm, or on graphs with
+ * at least a threshold number of vertices, with the parallel
+ * delta-stepping algorithm.
+ *
+ * Edge costs and lengths are of type Weight. Distances from a single
+ * Vertex are uint64_t, and sums over them are of type Total, which must be
+ * wide enough that they cannot overflow.
  */
+template <typename Weight, typename Total>
 class UndirectedGraph {
 public:
     /**
@@ -35,7 +55,7 @@ public:
      * If either of the named vertices does not exist, it is created.
      */
     void addEdge(const std::string &from, const std::string &to,
-                 unsigned int cost, unsigned int length);
+                 Weight cost, Weight length);
 
     /**
      * Returns the total cost of all edges in the graph.
@@ -43,7 +63,7 @@ public:
      * Since this graph is undirected, is calcualted as the cost
      * of all Edges terminating at all Vertices, divided by 2.
      */
-    unsigned int totalEdgeCost() const;
+    Total totalEdgeCost() const;
 
     /**
      * Removes all edges from the graph except those necessary to
@@ -58,14 +78,15 @@ public:
 
     /**
      * Determines the combined distance from the given Vertex to all
-     * other Vertices in the graph using Dijkstra's algorithm.
+     * other Vertices in the graph using Dijkstra's algorithm, or
+     * delta-stepping on large graphs.
      *
      * Returns max possible distance if the given Vertex does not appear
      * in the graph, or if any of the Vertices in the graph are not
      * reachable from the given Vertex. Otherwise, returns the combined
      * distance.
      */
-    unsigned int totalDistance(const std::string &from);
+    Total totalDistance(const std::string &from);
 
     /**
      * Determines the combined distance from all Vertices to all other
@@ -73,9 +94,54 @@ public:
      *
      * Returns max possible distance if the graph is not connected.
      */
-    unsigned int totalDistance();
+    Total totalDistance();
+
+    /**
+     * Determines the combined distance from all Vertices to all other
+     * Vertices in the graph, recording progress in the given Checkpoint.
+     *
+     * Sources are visited in name order. If the Checkpoint already holds
+     * progress for this graph, the sweep resumes from there.
+     */
+    Total totalDistance(Checkpoint *checkpoint);
+
+    /**
+     * Returns a hash of the graph's vertices and edges, independent of
+     * the order in which the edges were added.
+     */
+    std::uint64_t hash() const;
+
+    /**
+     * Sets the bucket width used by delta-stepping. If delta is 0 (the
+     * default), it is chosen from the distribution of edge lengths.
+     */
+    void setDelta(unsigned int delta);
+
+    /**
+     * Sets the minimum number of vertices for which shortest paths are
+     * found with delta-stepping rather than Dijkstra's algorithm.
+     */
+    void setDeltaSteppingThreshold(size_t minVertices);
+
+    /**
+     * Sets the number of threads used by delta-stepping. If threads is 0
+     * (the default), one thread is used per hardware thread.
+     */
+    void setThreads(unsigned int threads);
+
+    /**
+     * Sets the size of the smallest delta-stepping frontier that is split
+     * across threads.
+     */
+    void setParallelThreshold(size_t minFrontier);
 
 private:
+    /**
+     * Returns the delta-stepping engine for this graph, building a
+     * snapshot of the graph's adjacency if it is out of date.
+     */
+    DeltaStepping<Weight, Total> *getDeltaStepping();
+
     /**
      * Comparison functor for use with Dijkstra's algorithm. Allows Vertices
      * to be added to a priority queue more than once, with different weights.
@@ -90,14 +156,41 @@ private:
      */
     class DijkstraVertexComparator {
     public:
-        bool operator()(const std::pair<Vertex *, unsigned int> &left,
-                        const std::pair<Vertex *, unsigned int> &right);
+        bool operator()(const std::pair<Vertex<Weight, Total> *, std::uint64_t> &left,
+                        const std::pair<Vertex<Weight, Total> *, std::uint64_t> &right);
     };
 
     /**
      * Map of vertex name to Vertex.
      */
-    std::unordered_map<std::string, Vertex *> vertices;
+    std::unordered_map<std::string, Vertex<Weight, Total> *> vertices;
+
+    /**
+     * Delta-stepping engine over a snapshot of this graph. Built on first
+     * use and discarded whenever the graph changes.
+     */
+    DeltaStepping<Weight, Total> *deltaStepping;
+
+    /**
+     * Bucket width for delta-stepping, or 0 to choose automatically.
+     */
+    unsigned int delta;
+
+    /**
+     * Graphs with at least this many vertices use delta-stepping.
+     */
+    size_t deltaSteppingThreshold;
+
+    /**
+     * Number of delta-stepping threads, or 0 for one per hardware thread.
+     */
+    unsigned int threads;
+
+    /**
+     * Delta-stepping frontiers with at least this many vertices are split
+     * across threads.
+     */
+    size_t parallelThreshold;
 };
 
 #endif
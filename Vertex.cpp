@@ -1,4 +1,6 @@
 #include "Vertex.hpp"
+#include "Weights.hpp"
+#include <cstdint>
 #include <utility>
 #include <iostream>
 #include <iomanip>
@@ -6,18 +8,22 @@
 
 using namespace std;
 
-const std::string &Vertex::getName() const
+template <typename Weight, typename Total>
+const std::string &Vertex<Weight, Total>::getName() const
 {
     return this->name;
 }
 
-Vertex::Vertex(const std::string &name)
+template <typename Weight, typename Total>
+Vertex<Weight, Total>::Vertex(const std::string &name)
 {
     this->name = name;
     visited = false;
+    index = 0;
 }
 
-bool Vertex::addEdge(Vertex *to, unsigned int cost, unsigned int length)
+template <typename Weight, typename Total>
+bool Vertex<Weight, Total>::addEdge(Vertex *to, Weight cost, Weight length)
 {
     // This edge already exists
     if (edges.find(to->getName()) != edges.end())
@@ -30,39 +36,57 @@ bool Vertex::addEdge(Vertex *to, unsigned int cost, unsigned int length)
     else // The edge does not exist
     {
         // create a new edge
-        edges[to->getName()] = Edge(this, to, cost, length);
+        edges[to->getName()] = Edge<Weight, Total>(this, to, cost, length);
         return true;
     }
 }
 
-unsigned int Vertex::getDistance() const
+template <typename Weight, typename Total>
+uint64_t Vertex<Weight, Total>::getDistance() const
 {
     return distance;
 }
 
-void Vertex::setDistance(unsigned int distance)
+template <typename Weight, typename Total>
+void Vertex<Weight, Total>::setDistance(uint64_t distance)
 {
     this->distance = distance;
 }
 
-bool Vertex::wasVisited() const
+template <typename Weight, typename Total>
+bool Vertex<Weight, Total>::wasVisited() const
 {
     return visited;
 }
 
-void Vertex::setVisited(bool visited)
+template <typename Weight, typename Total>
+void Vertex<Weight, Total>::setVisited(bool visited)
 {
     this->visited = visited;
 }
 
-void Vertex::clearEdges()
+template <typename Weight, typename Total>
+unsigned int Vertex<Weight, Total>::getIndex() const
+{
+    return index;
+}
+
+template <typename Weight, typename Total>
+void Vertex<Weight, Total>::setIndex(unsigned int index)
+{
+    this->index = index;
+}
+
+template <typename Weight, typename Total>
+void Vertex<Weight, Total>::clearEdges()
 {
     edges.clear();
 }
 
-unsigned int Vertex::totalEdgeCost() const
+template <typename Weight, typename Total>
+Total Vertex<Weight, Total>::totalEdgeCost() const
 {
-    unsigned int total = 0;
+    Total total = 0;
     // Iterate through the edges unordered_map and calculate the total cost
     // of all edges
     for (auto &zod : edges)
@@ -72,7 +96,14 @@ unsigned int Vertex::totalEdgeCost() const
     return total;
 }
 
-const std::unordered_map<std::string, Edge> &Vertex::getEdges() const
+template <typename Weight, typename Total>
+const std::unordered_map<std::string, Edge<Weight, Total>> &Vertex<Weight, Total>::getEdges() const
 {
     return edges;
 }
+
+// Instantiate every pairing listed in Weights.hpp
+template class Vertex<uint16_t, uint64_t>;
+template class Vertex<uint16_t, uint128_t>;
+template class Vertex<uint32_t, uint64_t>;
+template class Vertex<uint32_t, uint128_t>;
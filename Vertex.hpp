@@ -1,21 +1,31 @@
 #ifndef VERTEX_HPP
 #define VERTEX_HPP
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include "Edge.hpp"
 
 #include <unordered_map>
+
+template <typename Weight, typename Total>
+class UndirectedGraph;
+
 /**
  * Represents a Vertex in a graph.
  *
  * Vertices are connected to other Vertices via Edges. Each Vertex
  * maintains a collection of all Edges that originate from it.
+ *
+ * Edge costs and lengths are of type Weight and sums of costs are of type
+ * Total. A single distance is a sum of at most |V| - 1 lengths, so it
+ * always fits in 64 bits.
  */
+template <typename Weight, typename Total>
 class Vertex
 {
     // Graph needs access to Edge map for Dijkstra/Prim algorithms.
-    friend class UndirectedGraph;
+    friend class UndirectedGraph<Weight, Total>;
 
 public:
     /**
@@ -28,7 +38,7 @@ public:
      * vertex, updates the cost and length of the edge to match the
      * passed parameters.
      */
-    bool addEdge(Vertex *to, unsigned int cost, unsigned int length);
+    bool addEdge(Vertex *to, Weight cost, Weight length);
 
     /**
      * Returns the Vertex's name.
@@ -38,12 +48,12 @@ public:
     /**
      * Gets the Vertex's distance value.
      */
-    unsigned int getDistance() const;
+    std::uint64_t getDistance() const;
 
     /**
      * Sets the Vertex's distance value.
      */
-    void setDistance(unsigned int distance);
+    void setDistance(std::uint64_t distance);
 
     /**
      * Gets the Vertex's visited state.
@@ -55,6 +65,16 @@ public:
      */
     void setVisited(bool visited);
 
+    /**
+     * Gets the Vertex's index.
+     */
+    unsigned int getIndex() const;
+
+    /**
+     * Sets the Vertex's index.
+     */
+    void setIndex(unsigned int index);
+
     /**
      * Clears all edges from this Vertex.
      */
@@ -63,14 +83,14 @@ public:
     /**
      * Gets total cost of all edges terminating at this Vertex.
      */
-    unsigned int totalEdgeCost() const;
+    Total totalEdgeCost() const;
 
 private:
     /**
      * Returns a reference to the internal map of Edges.
      * Used by UndirectedGraph for Dijkstra/Prim algorithms.
      */
-    const std::unordered_map<std::string, Edge> &getEdges() const;
+    const std::unordered_map<std::string, Edge<Weight, Total>> &getEdges() const;
 
     /**
      * Name of this Vertex.
@@ -81,7 +101,7 @@ private:
      * Distance of this Vertex from initial Vertex.
      * Used by Dijkstra's algorithm.
      */
-    unsigned int distance;
+    std::uint64_t distance;
 
     /**
      * Whether this node has been visited.
@@ -89,10 +109,16 @@ private:
      */
     bool visited;
 
+    /**
+     * Index of this Vertex in the graph's delta-stepping snapshot.
+     * Used by UndirectedGraph.
+     */
+    unsigned int index;
+
     /**
      * Map of adjacent Vertex name to Edge describing the adjacency.
      */
-    std::unordered_map<std::string, Edge> edges;
+    std::unordered_map<std::string, Edge<Weight, Total>> edges;
 };
 
 #endif
@@ -0,0 +1,79 @@
+#ifndef WEIGHTS_HPP
+#define WEIGHTS_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Edge weight and accumulator types for the graph classes.
+ *
+ * Edge, Vertex, UndirectedGraph and DeltaStepping are templates on a
+ * Weight type, which holds the cost and length of each edge, and a Total
+ * type, which holds sums of costs and of distances. The classes are
+ * explicitly instantiated for each pairing of:
+ *   Weight: uint16_t, uint32_t
+ *   Total:  uint64_t, uint128_t
+ *
+ * A single distance is at most |V| - 1 lengths, so distances themselves
+ * are always uint64_t, whatever the Total.
+ *
+ * netplan picks the narrowest Weight that holds the largest cost and length
+ * in its input, and the narrowest Total that holds the largest possible sum.
+ *
+ * A narrow Weight does not make Edge smaller: its two Vertex pointers pad
+ * it to 24 bytes either way. The saving is in the DeltaStepping length
+ * array, which holds one Weight per directed edge.
+ */
+
+/**
+ * 128-bit accumulator for graphs whose sums may not fit in 64 bits.
+ */
+typedef unsigned __int128 uint128_t;
+
+/**
+ * Returns the largest value of the given Total type. Used as the distance
+ * of unreachable vertices. std::numeric_limits is not specialized for
+ * uint128_t in strict standard mode, so this is used instead.
+ */
+template <typename Total>
+Total maxTotal()
+{
+    return ~Total(0);
+}
+
+/**
+ * Returns the decimal representation of a Total. Works for uint128_t,
+ * which the standard streams cannot print.
+ */
+template <typename Total>
+std::string totalToString(Total value)
+{
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), static_cast<char>('0' + value % 10));
+        value /= 10;
+    } while (value != 0);
+    return digits;
+}
+
+/**
+ * Parses the decimal representation of a Total. Returns false if str is
+ * not entirely digits or does not fit in a Total.
+ */
+template <typename Total>
+bool parseTotal(const std::string &str, Total &value)
+{
+    if (str.empty()) {
+        return false;
+    }
+    value = 0;
+    for (char c : str) {
+        if (c < '0' || c > '9' || value > (maxTotal<Total>() - (c - '0')) / 10) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "GraphGenerator.hpp"
+
+using namespace std;
+
+/**
+ * Largest number of threads accepted by -t.
+ */
+static const uint64_t MAX_THREADS = 1024;
+
+/**
+ * Prints the usage message for netgen to stderr.
+ */
+static void usage(const char *name)
+{
+    std::cerr << "Usage: " << name
+              << " [-s seed] [-t threads (at most " << MAX_THREADS << ")]"
+              << " [-l max_length] [-o outfile] family args" << std::endl
+              << "Families:" << std::endl
+              << "  sparse num_vertices degree" << std::endl
+              << "  powerlaw num_vertices degree" << std::endl
+              << "  complete num_vertices" << std::endl
+              << "  grid rows cols" << std::endl
+              << "  torus rows cols" << std::endl;
+}
+
+/**
+ * Parses a non-negative integer argument. Returns false if str is not
+ * entirely a number.
+ */
+static bool parseNumber(const char *str, uint64_t &value)
+{
+    char *end;
+    errno = 0;
+    value = strtoull(str, &end, 10);
+    return *str != '\0' && *str != '-' && *end == '\0' && errno == 0;
+}
+
+/**
+ * Entry point into the netgen program.
+ *
+ * Generates a synthetic netplan input file from one of several topology
+ * families. Every generated graph is connected, has a unique minimum
+ * spanning tree, and has no duplicate edges. The same seed always produces
+ * the same file, regardless of the number of threads.
+ *
+ * Usage:
+ *   ./netgen [-s seed] [-t threads] [-l max_length] [-o outfile] family args
+ *
+ * Example:
+ *   ./netgen -s 7 -o infile sparse 1000000 8
+ */
+int main(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    uint64_t threads = min<uint64_t>(std::thread::hardware_concurrency(), MAX_THREADS);
+    uint64_t maxLength = 15;
+    const char *outfile = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:l:o:")) != -1)
+    {
+        bool valid = true;
+        switch (opt)
+        {
+        case 's':
+            valid = parseNumber(optarg, seed);
+            break;
+        case 't':
+            valid = parseNumber(optarg, threads) && threads <= MAX_THREADS;
+            break;
+        case 'l':
+            valid = parseNumber(optarg, maxLength) && maxLength <= 0xffffffffULL;
+            break;
+        case 'o':
+            outfile = optarg;
+            break;
+        default:
+            valid = false;
+        }
+        if (!valid)
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    string familyName = argv[optind];
+    GraphGenerator::Family family;
+    int numArgs = 2;
+    if (familyName == "sparse")
+    {
+        family = GraphGenerator::SPARSE;
+    }
+    else if (familyName == "powerlaw")
+    {
+        family = GraphGenerator::POWERLAW;
+    }
+    else if (familyName == "complete")
+    {
+        family = GraphGenerator::COMPLETE;
+        numArgs = 1;
+    }
+    else if (familyName == "grid")
+    {
+        family = GraphGenerator::GRID;
+    }
+    else if (familyName == "torus")
+    {
+        family = GraphGenerator::TORUS;
+    }
+    else
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t size = 0;
+    uint64_t param = 0;
+    if (argc - optind - 1 != numArgs ||
+        !parseNumber(argv[optind + 1], size) ||
+        (numArgs == 2 && !parseNumber(argv[optind + 2], param)))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        GraphGenerator generator(family, size, param, seed,
+                                 static_cast<unsigned int>(maxLength));
+
+        FILE *out = stdout;
+        if (outfile)
+        {
+            out = fopen(outfile, "wb");
+            if (!out)
+            {
+                std::cerr << "Unable to open file for writing." << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        bool ok = generator.write(out, static_cast<unsigned int>(threads > 0 ? threads : 1));
+        if (outfile && fclose(out) != 0)
+        {
+            ok = false;
+        }
+        if (!ok)
+        {
+            std::cerr << "Error writing output: " << strerror(errno) << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
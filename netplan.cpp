@@ -1,12 +1,142 @@
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <unordered_map>
+#include <unistd.h>
+#include <utility>
+#include <vector>
 
 #include "UndirectedGraph.hpp"
+#include "Weights.hpp"
 
 using namespace std;
+
+/**
+ * An edge as read from the input file. Vertices are numbered in the order
+ * they first appear.
+ */
+struct InputEdge
+{
+    unsigned int from;
+    unsigned int to;
+    unsigned int cost;
+    unsigned int latency;
+};
+
+/**
+ * Largest number of delta-stepping threads accepted by -t.
+ */
+const unsigned long long MAX_THREADS = 1024;
+
+/**
+ * How shortest paths are found, as set on the command line.
+ */
+struct ShortestPathOptions
+{
+    // Delta-stepping bucket width, or 0 to choose automatically
+    unsigned int delta;
+    // Graphs with at least this many vertices use delta-stepping
+    size_t minVertices;
+    // Delta-stepping threads, or 0 for one per hardware thread
+    unsigned int threads;
+    // Frontiers with at least this many vertices are split across threads
+    size_t minFrontier;
+};
+
+/**
+ * Applies the given shortest path options to a graph.
+ */
+template <typename Weight, typename Total>
+static void configure(UndirectedGraph<Weight, Total> *graph,
+                      const ShortestPathOptions &options)
+{
+    graph->setDelta(options.delta);
+    graph->setDeltaSteppingThreshold(options.minVertices);
+    graph->setThreads(options.threads);
+    graph->setParallelThreshold(options.minFrontier);
+}
+
+/**
+ * Builds the graph described by names and edges with the given weight and
+ * accumulator types, then prints the six results for it. names and edges
+ * are released once the graph is built. Shortest paths are found as set
+ * in options.
+ */
+template <typename Weight, typename Total>
+static void plan(vector<string> &&names, vector<InputEdge> &&edges,
+                 Checkpoint *checkpoint, const ShortestPathOptions &options)
+{
+    // Total cost of creating all possible network links
+    Total totalCost = 0;
+    // Cost of building the MST
+    Total MSTCost = 0;
+    // Total latency to send a packet between all pairs of computers
+    Total totalDistance = 0;
+    Total MSTDistance = 0;
+
+    // This will be the graph from the original input file
+    UndirectedGraph<Weight, Total> *originalGraph = new UndirectedGraph<Weight, Total>();
+    configure(originalGraph, options);
+    for (auto &edge : edges)
+    {
+        originalGraph->addEdge(names[edge.from], names[edge.to],
+                               static_cast<Weight>(edge.cost),
+                               static_cast<Weight>(edge.latency));
+    }
+    // The graph holds its own copy of everything, so free the input
+    vector<string>().swap(names);
+    vector<InputEdge>().swap(edges);
+    // Get the total cost of all edges in the original graph
+    totalCost = originalGraph->totalEdgeCost();
+    // #1
+    cout << totalToString(totalCost) << endl;
+    // Find the MST of the original graph
+    UndirectedGraph<Weight, Total> *MST = originalGraph->minSpanningTree();
+    configure(MST, options);
+    // Keep the progress recorded for both sweeps, and drop any left over
+    // from other inputs
+    if (checkpoint)
+    {
+        checkpoint->retain(originalGraph->hash());
+        checkpoint->retain(MST->hash());
+    }
+    // Find the cost of all edges in the MST
+    MSTCost = MST->totalEdgeCost();
+    // #2
+    cout << totalToString(MSTCost) << endl;
+    // #3
+    cout << totalToString(totalCost - MSTCost) << endl;
+
+    // Run Dijkstra on all vertices in the original graph and return the
+    // sum of all shortest paths
+    totalDistance += originalGraph->totalDistance(checkpoint);
+    // #4
+    cout << totalToString(totalDistance) << endl;
+
+    // Run Dijkstra on all vertices in the MST and return the sum of all shortest
+    // paths
+    MSTDistance += MST->totalDistance(checkpoint);
+    // #5
+    cout << totalToString(MSTDistance) << endl;
+    // #6
+    // A disconnected graph's distance is the max Total, so the difference
+    // would wrap around; report the max Total instead
+    if (totalDistance == maxTotal<Total>() || MSTDistance == maxTotal<Total>())
+    {
+        cout << totalToString(maxTotal<Total>()) << endl;
+    }
+    else
+    {
+        cout << totalToString(MSTDistance - totalDistance) << endl;
+    }
+
+    delete MST;
+    delete originalGraph;
+}
+
 /**
  * Entry point into the netplan program.
  *
@@ -20,15 +150,81 @@ using namespace std;
  *  minimum cost graph.
  * -Prints the results to stdout.
  *
+ * The graph classes are instantiated with the narrowest edge weight type
+ * that holds every cost and latency in the file, and the narrowest
+ * accumulator type that holds the largest sum the graph could produce.
+ *
+ * If a checkpoint file is given, progress through the shortest path sweeps
+ * is saved there periodically. Rerunning with the same infile and checkpoint
+ * file resumes the sweeps instead of starting over.
+ *
+ * Shortest paths are found with delta-stepping on graphs with at least
+ * min_vertices vertices (65536 by default), using the given bucket width
+ * (chosen from the edge lengths by default). Passing -m 0 forces
+ * delta-stepping on every graph.
+ *
+ * Delta-stepping uses the given number of threads (one per hardware thread
+ * by default), and splits frontiers of at least min_frontier vertices
+ * (4096 by default) across them. Passing -p 1 splits every frontier.
+ *
  * Usage:
- *   ./netplan infile
+ *   ./netplan [-d delta] [-m min_vertices] [-t threads] [-p min_frontier]
+ *             infile [checkpoint]
  *
  */
 int main(int argc, char **argv)
 {
-    if (argc != 2)
+    const char *name = argv[0];
+    ShortestPathOptions options;
+    options.delta = 0;
+    options.minVertices = DELTA_STEPPING_MIN_VERTICES;
+    options.threads = 0;
+    options.minFrontier = DELTA_STEPPING_MIN_PARALLEL_FRONTIER;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:m:t:p:")) != -1)
+    {
+        char *end = nullptr;
+        unsigned long long value = 0;
+        if (opt != '?')
+        {
+            value = strtoull(optarg, &end, 10);
+        }
+        if (!end || *end != '\0' || *optarg == '\0' || *optarg == '-' ||
+            (opt == 'd' && value > UINT32_MAX) ||
+            (opt == 't' && value > MAX_THREADS))
+        {
+            std::cerr << "Usage: " << name << " [-d delta] [-m min_vertices]"
+                      << " [-t threads (at most " << MAX_THREADS << ")]"
+                      << " [-p min_frontier] infile [checkpoint]" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (opt == 'd')
+        {
+            options.delta = static_cast<unsigned int>(value);
+        }
+        else if (opt == 'm')
+        {
+            options.minVertices = static_cast<size_t>(value);
+        }
+        else if (opt == 't')
+        {
+            options.threads = static_cast<unsigned int>(value);
+        }
+        else
+        {
+            options.minFrontier = static_cast<size_t>(value);
+        }
+    }
+    // Shift the options out so the positional arguments are at argv[1]
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    if (argc != 2 && argc != 3)
     {
-        std::cerr << "Usage: " << argv[0] << " infile" << std::endl;
+        std::cerr << "Usage: " << name << " [-d delta] [-m min_vertices]"
+                  << " [-t threads (at most " << MAX_THREADS << ")]"
+                  << " [-p min_frontier] infile [checkpoint]" << std::endl;
         return EXIT_FAILURE;
     }
 
@@ -60,52 +256,81 @@ int main(int argc, char **argv)
     string to;
     unsigned int cost;
     unsigned int latency;
-    // Total cost of creating all possible network links
-    unsigned int totalCost = 0;
-    // Cost of building the MST
-    unsigned int MSTCost = 0;
-    // Total latency to send a packet between all pairs of computers
-    unsigned int totalDistance = 0;
-    unsigned int MSTDistance = 0;
+    // Largest cost or latency in the input
+    unsigned int maxWeight = 0;
+    unsigned int maxLatency = 0;
 
-    // This will be the graph from the original input file
-    UndirectedGraph *originalGraph = new UndirectedGraph();
-    // Build the graph based on the contents of the input file
+    // Read the whole input first, since the types used for the graph
+    // depend on its size and largest weight
+    unordered_map<string, unsigned int> indices;
+    vector<string> names;
+    vector<InputEdge> edges;
+    // Returns the number of the named vertex, numbering it if it is new
+    auto vertexIndex = [&](const string &name)
+    {
+        auto found = indices.find(name);
+        if (found == indices.end())
+        {
+            found = indices.insert(make_pair(name, names.size())).first;
+            names.push_back(name);
+        }
+        return found->second;
+    };
     in.seekg(0, in.beg);
     while (in >> from && in >> to && in >> cost && in >> latency)
     {
-        originalGraph->addEdge(from, to, cost, latency);
+        InputEdge edge;
+        edge.from = vertexIndex(from);
+        edge.to = vertexIndex(to);
+        edge.cost = cost;
+        edge.latency = latency;
+        edges.push_back(edge);
+        maxWeight = max(maxWeight, max(cost, latency));
+        maxLatency = max(maxLatency, latency);
         if (in.peek() == -1) break;
     }
-    // Get the total cost of all edges in the original graph
-    totalCost = originalGraph->totalEdgeCost();
-    // #1
-    cout << totalCost << endl;
-    // Find the MST of the original graph
-    UndirectedGraph *MST = originalGraph->minSpanningTree();
-    // Find the cost of all edges in the MST
-    MSTCost = MST->totalEdgeCost();
-    // #2
-    cout << MSTCost << endl;
-    // #3
-    cout << totalCost - MSTCost << endl;
+    // Only needed while reading, so free it before building the graph
+    unordered_map<string, unsigned int>().swap(indices);
 
-    // Run Dijkstra on all vertices in the original graph and return the
-    // sum of all shortest paths
-    totalDistance += originalGraph->totalDistance();
-    // #4
-    cout << totalDistance << endl;
+    // Records progress through the distance sweeps, if requested
+    Checkpoint *checkpoint = nullptr;
+    if (argc == 3)
+    {
+        checkpoint = new Checkpoint(argv[2]);
+    }
 
-    // Run Dijkstra on all vertices in the MST and return the sum of all shortest
-    // paths
-    MSTDistance += MST->totalDistance();
-    // #5
-    cout << MSTDistance << endl;
-    // #6
-    cout << MSTDistance - totalDistance << endl;
+    // Bound the largest sum: every ordered pair of vertices at the longest
+    // possible simple path, or every edge at the largest cost
+    long double vertices = names.size();
+    long double maxSum = max(vertices * vertices * vertices * maxLatency,
+                             static_cast<long double>(edges.size()) * maxWeight);
+    // Leave a margin below 2^64 for rounding in the bound
+    bool wideTotals = maxSum >= 9.0e18L;
 
-    delete MST;
-    delete originalGraph;
+    if (maxWeight <= UINT16_MAX)
+    {
+        if (wideTotals)
+        {
+            plan<uint16_t, uint128_t>(std::move(names), std::move(edges), checkpoint, options);
+        }
+        else
+        {
+            plan<uint16_t, uint64_t>(std::move(names), std::move(edges), checkpoint, options);
+        }
+    }
+    else
+    {
+        if (wideTotals)
+        {
+            plan<uint32_t, uint128_t>(std::move(names), std::move(edges), checkpoint, options);
+        }
+        else
+        {
+            plan<uint32_t, uint64_t>(std::move(names), std::move(edges), checkpoint, options);
+        }
+    }
+
+    delete checkpoint;
 
     return EXIT_SUCCESS;
 }
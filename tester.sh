@@ -7,3 +7,96 @@ do
         rm "refnetfile";
         rm "netplanfile";
 done
+# Force delta-stepping on every graph and compare it with Dijkstra
+for i in `seq 1 100`;
+do
+        ./netplan "tests/$i" > "netplanfile";
+        ./netplan -m 0 "tests/$i" > "deltafile";
+        diff "netplanfile" "deltafile";
+        rm "netplanfile";
+        rm "deltafile";
+done
+# Force delta-stepping with every frontier split across four threads, so
+# the worker pool runs even on these small graphs
+for i in `seq 1 100`;
+do
+        ./netplan "tests/$i" > "netplanfile";
+        ./netplan -m 0 -t 4 -p 1 "tests/$i" > "deltafile";
+        diff "netplanfile" "deltafile";
+        rm "netplanfile";
+        rm "deltafile";
+done
+# netgen must produce the same file for a seed regardless of the number of
+# threads. These graphs span several blocks, so four threads share them.
+for family in "sparse 200000 4" "powerlaw 200000 4" "complete 800" "grid 600 600" "torus 600 600";
+do
+        ./netgen -s 7 -t 1 $family > "genfile";
+        ./netgen -s 7 -t 4 $family > "genfile4";
+        cmp "genfile" "genfile4";
+        rm "genfile";
+        rm "genfile4";
+done
+# Every generated graph must be connected, with distinct costs and no
+# duplicate edges. An unreachable vertex makes netplan print the max total.
+for family in "sparse 60 3" "sparse 60 59" "powerlaw 60 3" "powerlaw 60 40" "complete 20" "grid 6 7" "torus 6 7" "torus 3 3";
+do
+        ./netgen -s 7 $family > "genfile";
+        ./netplan "genfile" | grep -x "18446744073709551615" > /dev/null && echo "netgen $family: not connected";
+        awk -v family="$family" '{ a = $1 < $2 ? $1 : $2; b = $1 < $2 ? $2 : $1;
+                if (edges[a " " b]++) print "netgen " family ": duplicate edge " a " " b;
+                if (costs[$3]++) print "netgen " family ": duplicate cost " $3; }' "genfile";
+        rm "genfile";
+done
+# A torus smaller than 3x3 would wrap onto its own edges
+for family in "torus 2 3" "torus 3 2";
+do
+        if ./netgen $family > /dev/null 2>&1;
+        then
+                echo "netgen accepted $family";
+        fi
+done
+# Checkpoints. In this triangle the original graph's distances sum to 10,
+# of which source a (swept first) contributes 3, and the MST's sum to 12.
+printf "a b 1 1\nb c 2 2\na c 3 2\n" > "checkgraph";
+./netplan "checkgraph" > "netplanfile";
+rm -f "checkpointfile";
+# A fresh run, then a rerun resuming from the finished checkpoint
+./netplan "checkgraph" "checkpointfile" > "resumefile";
+diff "netplanfile" "resumefile";
+./netplan "checkgraph" "checkpointfile" > "resumefile";
+diff "netplanfile" "resumefile";
+hash=`awk '$4 == 10 { print $1 }' "checkpointfile"`;
+# Resume the original graph's sweep after its first source
+printf "netplan-checkpoint 2\n$hash 3 1 3\n" > "checkpointfile";
+./netplan "checkgraph" "checkpointfile" > "resumefile";
+diff "netplanfile" "resumefile";
+# The recorded partial sum is trusted, so an extra 1000 must show up
+printf "netplan-checkpoint 2\n$hash 3 1 1003\n" > "checkpointfile";
+if [ "`./netplan "checkgraph" "checkpointfile" | sed -n 4p`" != "1010" ];
+then
+        echo "checkpoint record was not resumed";
+fi
+# Malformed records are ignored, and records for other graphs are dropped
+printf "netplan-checkpoint 2\n$hash 3 4 3\n$hash 3 1\n12345 3 1 3\n" > "checkpointfile";
+./netplan "checkgraph" "checkpointfile" > "resumefile";
+diff "netplanfile" "resumefile";
+if grep -q "^12345 " "checkpointfile";
+then
+        echo "stale checkpoint record was kept";
+fi
+# A checkpoint from another format version is ignored
+printf "netplan-checkpoint 1\n$hash 3 1 1003\n" > "checkpointfile";
+./netplan "checkgraph" "checkpointfile" > "resumefile";
+diff "netplanfile" "resumefile";
+rm "checkgraph";
+rm "netplanfile";
+rm "resumefile";
+rm "checkpointfile";
+# TestCases with known outputs: weights above 16 bits, sums above 64 bits,
+# and a disconnected graph
+for name in `ls TestCasesExpected`;
+do
+        ./netplan "TestCases/$name" > "netplanfile";
+        diff "TestCasesExpected/$name" "netplanfile";
+        rm "netplanfile";
+done